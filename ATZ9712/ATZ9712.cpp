@@ -449,17 +449,7 @@ HANDLE OpenATZ912Port(LPCWSTR PortName)
 		return 0;
 	}
 
-	DCB dcbSerialParams = { 0 };
-	dcbSerialParams.DCBlength = sizeof(dcbSerialParams);
-
-	bool Status = GetCommState(hSerialPort1, &dcbSerialParams);
-
-	dcbSerialParams.BaudRate = CBR_9600;	// Setting BaudRate = 9600
-	dcbSerialParams.ByteSize = 8;			// Setting ByteSize = 8
-	dcbSerialParams.StopBits = ONESTOPBIT;	// Setting StopBits = 1
-	dcbSerialParams.Parity = NOPARITY;		// Setting Parity = None
-	
-	SetCommState(hSerialPort1, &dcbSerialParams);
+	SetATZ912BaudRate(hSerialPort1, CBR_9600);
 
 	// All timeouts in milliseconds
 	COMMTIMEOUTS timeouts = { 0 };
@@ -473,4 +463,168 @@ HANDLE OpenATZ912Port(LPCWSTR PortName)
 	PurgeComm(hSerialPort1, PURGE_RXABORT | PURGE_TXABORT | PURGE_RXCLEAR | PURGE_TXCLEAR);
 
 	return (hSerialPort1);
-}
\ No newline at end of file
+}
+
+bool SetATZ912BaudRate(HANDLE hPort, DWORD baud_rate)
+{
+	DCB dcbSerialParams = { 0 };
+	dcbSerialParams.DCBlength = sizeof(dcbSerialParams);
+
+	if (!GetCommState(hPort, &dcbSerialParams))
+		return(ERROR);
+
+	dcbSerialParams.BaudRate = baud_rate;	// Setting BaudRate
+	dcbSerialParams.ByteSize = 8;			// Setting ByteSize = 8
+	dcbSerialParams.StopBits = ONESTOPBIT;	// Setting StopBits = 1
+	dcbSerialParams.Parity = NOPARITY;		// Setting Parity = None
+
+	if (!SetCommState(hPort, &dcbSerialParams))
+		return(ERROR);
+
+	PurgeComm(hPort, PURGE_RXABORT | PURGE_TXABORT | PURGE_RXCLEAR | PURGE_TXCLEAR);
+
+	return(1);
+}
+
+// Silent REG_MODEL read used while probing. Unlike ReadRegisterInt, a CRC
+// error is treated as a failure, and there is no fixed Sleep(20) - ReadFile
+// returns as soon as the response arrives, so the timing reflects the link.
+static bool ProbeModel(HANDLE hPort, uint8_t dev_address, DWORD *bytes)
+{
+	DWORD dwBytesWritten;
+	DWORD dwBytesRead;
+
+	struct READ_REG_REQUEST request;
+	request.address = dev_address;
+	request.functionCode = FUNCTION_READ_MULTIPLE_HOLDING_REGISTERS;
+	request.reg = _byteswap_ushort(REG_MODEL);
+	request.registersToRead = _byteswap_ushort(0x01);
+	request.CRC = Calc_CRC(&request, sizeof(request) - 2);
+
+	if (!WriteFile(hPort, &request, sizeof(request), &dwBytesWritten, NULL) || dwBytesWritten != sizeof(request))
+		return(ERROR);
+
+	struct READ_REG_INT_RESPONSE response;
+
+	if (!ReadFile(hPort, &response, sizeof(response), &dwBytesRead, 0) || dwBytesRead != sizeof(response))
+		return(ERROR);
+
+	if (response.address != request.address || response.functionCode != request.functionCode || response.byteCount != 2)
+		return(ERROR);
+
+	if (response.CRC != Calc_CRC(&response, sizeof(response) - 2))
+		return(ERROR);
+
+	*bytes += dwBytesWritten + dwBytesRead;
+	return(1);
+}
+
+// Run 'transactions' back to back REG_MODEL reads at the current rate and count
+// the ones that time out or fail the CRC. Throughput is in bytes/second of
+// request and response traffic for the reads that succeeded.
+static int SoakTest(HANDLE hPort, uint8_t dev_address, int transactions, float *throughput)
+{
+	LARGE_INTEGER freq, start, end;
+	DWORD bytes = 0;
+	int errors = 0;
+
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&start);
+
+	for (int i = 0; i < transactions; i++) {
+		if (!ProbeModel(hPort, dev_address, &bytes)) {
+			PurgeComm(hPort, PURGE_RXABORT | PURGE_TXABORT | PURGE_RXCLEAR | PURGE_TXCLEAR);
+			errors++;
+		}
+	}
+
+	QueryPerformanceCounter(&end);
+
+	*throughput = (float)bytes * (float)freq.QuadPart / (float)(end.QuadPart - start.QuadPart);
+	return(errors);
+}
+
+// A rate is taken to be the device's if any of a few REG_MODEL reads returns a valid frame
+static bool DetectRate(HANDLE hPort, uint8_t dev_address, DWORD baud_rate)
+{
+	DWORD bytes = 0;
+
+	if (!SetATZ912BaudRate(hPort, baud_rate))
+		return(ERROR);
+
+	for (int i = 0; i < BAUD_DETECT_ATTEMPTS; i++) {
+		if (ProbeModel(hPort, dev_address, &bytes))
+			return(1);
+		PurgeComm(hPort, PURGE_RXABORT | PURGE_TXABORT | PURGE_RXCLEAR | PURGE_TXCLEAR);
+	}
+	return(ERROR);
+}
+
+static void GetBaudIniPath(WCHAR *path, DWORD length)
+{
+	// Keep the store next to the executable so it does not depend on the current directory
+	DWORD ret = GetModuleFileNameW(NULL, path, length);
+	if (ret == 0 || ret >= length) {
+		wcscpy_s(path, length, BAUD_INI_FILE);
+		return;
+	}
+
+	WCHAR *slash = wcsrchr(path, L'\\');
+	if (slash == NULL || (DWORD)(slash - path) + 1 + wcslen(BAUD_INI_FILE) >= length) {
+		wcscpy_s(path, length, BAUD_INI_FILE);
+		return;
+	}
+	wcscpy_s(slash + 1, length - (slash + 1 - path), BAUD_INI_FILE);
+}
+
+// The load's baud rate is set on its front panel and cannot be changed over
+// MODBUS, so this only detects the rate the device is configured for. The host
+// UART is switched between the standard rates until a valid REG_MODEL frame
+// comes back. The link is then soaked at that rate and the error count and
+// effective throughput are returned; errors do not cause the open to fail.
+HANDLE OpenATZ912PortAutoBaud(LPCWSTR PortName, uint8_t dev_address, DWORD *baud_rate, float *throughput, int *errors)
+{
+	static const DWORD rates[] = { CBR_115200, CBR_57600, CBR_38400, CBR_19200, CBR_9600 };
+	const int num_rates = (int)(sizeof(rates) / sizeof(rates[0]));
+
+	HANDLE hSerialPort1 = OpenATZ912Port(PortName);
+	if (hSerialPort1 == 0)
+		return 0;
+
+	WCHAR iniPath[MAX_PATH];
+	GetBaudIniPath(iniPath, MAX_PATH);
+
+	// Try the rate saved for this port last time first, if it is one we know
+	DWORD saved = GetPrivateProfileIntW(BAUD_INI_SECTION, PortName, 0, iniPath);
+	DWORD detected = 0;
+	for (int i = 0; i < num_rates; i++) {
+		if (saved == rates[i] && DetectRate(hSerialPort1, dev_address, saved)) {
+			detected = saved;
+			break;
+		}
+	}
+
+	for (int i = 0; i < num_rates && detected == 0; i++) {
+		if (rates[i] != saved && DetectRate(hSerialPort1, dev_address, rates[i]))
+			detected = rates[i];
+	}
+
+	if (detected == 0) {
+		printf("Unable to detect device baud rate\n");
+		CloseHandle(hSerialPort1);
+		return 0;
+	}
+
+	if (detected != saved) {
+		WCHAR value[16];
+		swprintf_s(value, 16, L"%lu", detected);
+		WritePrivateProfileStringW(BAUD_INI_SECTION, PortName, value, iniPath);
+	}
+
+	*baud_rate = detected;
+	*errors = SoakTest(hSerialPort1, dev_address, BAUD_SOAK_TRANSACTIONS, throughput);
+	if (*errors != 0)
+		printf("Warning: %d of %d reads failed at %lu baud\r\n", *errors, BAUD_SOAK_TRANSACTIONS, detected);
+
+	return (hSerialPort1);
+}
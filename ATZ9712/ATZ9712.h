@@ -23,6 +23,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include <stdint.h>
 
 HANDLE OpenATZ912Port(LPCWSTR PortName);
+HANDLE OpenATZ912PortAutoBaud(LPCWSTR PortName, uint8_t dev_address, DWORD *baud_rate, float *throughput, int *errors);
+bool SetATZ912BaudRate(HANDLE hPort, DWORD baud_rate);
 bool ReadCoil(HANDLE hPort, uint8_t address, uint16_t coil_number, bool *value);
 bool ReadRegisterFloat(HANDLE hPort, uint8_t dev_address, uint16_t reg_addr, float *value);
 bool ReadRegisterInt(HANDLE hPort, uint8_t dev_address, uint16_t reg_addr, uint16_t *value);
@@ -33,6 +35,12 @@ bool WriteRegisterInt(HANDLE hPort, uint8_t dev_address, uint16_t reg_addr, uint
 
 uint16_t Calc_CRC(LPCVOID pointer, uint16_t length);
 
+// Baud rate detection
+#define BAUD_DETECT_ATTEMPTS		3				// REG_MODEL reads tried at each rate while detecting
+#define BAUD_SOAK_TRANSACTIONS		50				// REG_MODEL reads used to measure the link at the detected rate
+#define BAUD_INI_FILE				L"ATZ9712.ini"	// Per port baud rate store (executable directory)
+#define BAUD_INI_SECTION			L"BaudRate"
+
 #define FUNCTION_READ_COILS							0x01
 #define FUNCTION_READ_MULTIPLE_HOLDING_REGISTERS	0x03
 #define FUNCTION_WRITE_SINGLE_COIL					0x05
@@ -26,7 +26,14 @@ int main()
 {
 	printf("ATZ9712 Example\r\nwww.beyondlogic.org\r\n");
 
-	HANDLE hDCLoad = OpenATZ912Port(TEXT("COM5"));
+	DWORD baud;
+	float throughput;
+	int errors;
+
+	HANDLE hDCLoad = OpenATZ912PortAutoBaud(TEXT("COM5"), 1, &baud, &throughput, &errors);
+	if (hDCLoad == 0)
+		return 1;
+	printf("Link %lu baud, %.0f bytes/s effective, %d errors\r\n", baud, throughput, errors);
 
 	bool state;
 	float value, voltage, current;